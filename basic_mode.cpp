@@ -1,15 +1,20 @@
 #include "basic_mode.h"
 #include "ui_basic_mode.h"
-#include <queue>
+#include "game_resources.h"
+#include <QElapsedTimer>
 
-basic_mode::basic_mode(QWidget *parent)
+basic_mode::basic_mode(QWidget *parent, const game_variant &variant)
     : QWidget(parent)
     , ui(new Ui::basic_mode)
+    , engine(llk_engine::create(variant))
 {
+    QElapsedTimer timer;
+    timer.start();
     ui->setupUi(this);
     this->setAttribute(Qt::WA_DeleteOnClose);
     extractElements();
-    backgroundPixmap.load(":/resource/fruit_b0g.bmp");
+    backgroundPixmap = game_resources::background();
+    game_resources::requestBoard(variant);
     score = 0;
     gameTime = 300;
     gameOver = true;
@@ -19,19 +24,37 @@ basic_mode::basic_mode(QWidget *parent)
     hintPos2 = {-1, -1};
     setButtonInteractions(false);
     ui->BTN_START->setEnabled(true);
+    game_resources::logPhase(QString("basic_mode constructed in %1 ms").arg(timer.elapsed()));
 }
 
 basic_mode::~basic_mode()
 {
+    solveCancelled = true;
+    if (solveTask.valid()) {
+        solveTask.wait();
+    }
     delete ui;
 }
 
 void basic_mode::on_BTN_START_clicked()
 {
+    // 停止上一局的自动求解，等待后台求解返回后再开始新的一局
+    solveCancelled = true;
+    if (solveTask.valid()) {
+        solveTask.wait();
+    }
+    stopAutoPlay();
+
     ui->BTN_START->setEnabled(false);
     setButtonInteractions(true);
 
-    generateMap();
+    game_resources::Board board = game_resources::takeBoard(engine->variant());
+    if (board.mapData.size() == 10 && elements.size() == game_resources::ElementCount) {
+        mapData = std::move(board.mapData);
+        adjMatrix = std::move(board.adjMatrix);
+    } else {
+        generateMap();
+    }
     buildAdjMatrix();
     update();
 
@@ -48,6 +71,10 @@ void basic_mode::timerEvent(QTimerEvent *event)
         ui->CountDownBar->setValue(gameTime);
         if (gameTime <= 0) {
             killTimer(timerId);
+            // 对话框是模态的，打开前先结束游戏并停止自动求解，避免对话框后继续消除
+            gameOver = true;
+            solveCancelled = true;
+            stopAutoPlay();
             showLoseMessage();
             setButtonInteractions(false);
             ui->BTN_START->setEnabled(true);
@@ -81,14 +108,14 @@ void basic_mode::checkGameStatus()
 
 void basic_mode::showWinMessage()
 {
-    QMessageBox::information(this, "游戏胜利", "恭喜你，成功消除所有图案！");
     gameOver = true;
+    QMessageBox::information(this, "游戏胜利", "恭喜你，成功消除所有图案！");
 }
 
 void basic_mode::showLoseMessage()
 {
-    QMessageBox::information(this, "游戏失败", "时间已到，未能消除所有图案！");
     gameOver = true;
+    QMessageBox::information(this, "游戏失败", "时间已到，未能消除所有图案！");
 }
 
 void basic_mode::paintEvent(QPaintEvent *event)
@@ -136,6 +163,11 @@ void basic_mode::paintEvent(QPaintEvent *event)
             int col1 = connectionPath[i].second;
             int row2 = connectionPath[i + 1].first;
             int col2 = connectionPath[i + 1].second;
+            // 穿越边界的两个界外点之间不连线
+            if ((row1 < 0 || row1 >= 10 || col1 < 0 || col1 >= 16) &&
+                (row2 < 0 || row2 >= 10 || col2 < 0 || col2 >= 16)) {
+                continue;
+            }
             painter.drawLine(col1 * 40 + offsetX + 20, row1 * 40 + offsetY + 20,
                              col2 * 40 + offsetX + 20, row2 * 40 + offsetY + 20);
         }
@@ -144,237 +176,78 @@ void basic_mode::paintEvent(QPaintEvent *event)
 
 void basic_mode::generateMap()
 {
-    mapData.clear();
-    mapData.resize(10, QVector<int>(16, -1));
-
-    int elementIndex = 0;
-    for (int i = 0; i < 10; ++i) {
-        for (int j = 0; j < 16; j += 2) {
-            mapData[i][j] = elementIndex;
-            mapData[i][j + 1] = elementIndex;
-            elementIndex = (elementIndex + 1) % elements.size();
-        }
-    }
-
-    shuffleMap();
-}
-
-void basic_mode::shuffleMap()
-{
-    const int shuffleTimes = 100;
-    for (int i = 0; i < shuffleTimes; ++i) {
-        int row1 = QRandomGenerator::global()->bounded(10);
-        int col1 = QRandomGenerator::global()->bounded(16);
-        int row2 = QRandomGenerator::global()->bounded(10);
-        int col2 = QRandomGenerator::global()->bounded(16);
-
-        int temp = mapData[row1][col1];
-        mapData[row1][col1] = mapData[row2][col2];
-        mapData[row2][col2] = temp;
-    }
+    mapData = game_resources::generateMap(elements.size());
 }
 
 void basic_mode::extractElements()
 {
-    elementPixmap.load(":/resource/fruit_element.bmp");
-    maskPixmap.load(":/resource/fruit_mask.bmp");
-
-    for (int i = 0; i < 20; ++i) {
-        QPixmap element = elementPixmap.copy(0, i * 40, 40, 40);
-        QPixmap mask = maskPixmap.copy(0, i * 40, 40, 40);
-        element.setMask(mask.createMaskFromColor(Qt::black));
-        elements.append(element);
-    }
+    elements = game_resources::elements();
 }
 
 void basic_mode::buildAdjMatrix()
 {
-    int numNodes = 10 * 16;
-    adjMatrix.clear();
-    adjMatrix.resize(numNodes, QVector<bool>(numNodes, false));
-
-    for (int i1 = 0; i1 < 10; ++i1) {
-        for (int j1 = 0; j1 < 16; ++j1) {
-            if (mapData[i1][j1] != -1) {
-                for (int i2 = 0; i2 < 10; ++i2) {
-                    for (int j2 = 0; j2 < 16; ++j2) {
-                        if (i1 != i2 || j1 != j2) {
-                            if (mapData[i2][j2] != -1) {
-                                QPair<int, int> pos1 = {i1, j1};
-                                QPair<int, int> pos2 = {i2, j2};
-                                if (canEliminate(pos1, pos2)) {
-                                    int index1 = i1 * 16 + j1;
-                                    int index2 = i2 * 16 + j2;
-                                    adjMatrix[index1][index2] = true;
-                                    adjMatrix[index2][index1] = true;
-                                }
-                            }
-                        }
-                    }
-                }
-            }
+    std::vector<int> cells;
+    cells.reserve(10 * 16);
+    for (int i = 0; i < 10; ++i) {
+        for (int j = 0; j < 16; ++j) {
+            cells.push_back(mapData[i][j]);
         }
     }
+    engine->load(cells);
+    updateAdjMatrix();
 }
 
-bool basic_mode::canEliminate(const QPair<int, int> &pos1, const QPair<int, int> &pos2)
+void basic_mode::updateAdjMatrix()
 {
-    if (pos1 == pos2) return false;
-    int row1 = pos1.first;
-    int col1 = pos1.second;
-    int row2 = pos2.first;
-    int col2 = pos2.second;
-    if (mapData[row1][col1] != mapData[row2][col2]) return false;
-
-    struct Node {
-        int row;
-        int col;
-        int turns;
-        QVector<QPair<int, int>> path;
-    };
-
-    std::queue<Node> q;
-    QVector<QVector<bool>> visited(mapData.size(), QVector<bool>(mapData[0].size(), false));
-    QVector<QVector<int>> directions = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
-
-    q.push({row1, col1, 0, {pos1}});
-    visited[row1][col1] = true;
-
-    while (!q.empty()) {
-        Node current = q.front();
-        q.pop();
-
-        if (current.row == row2 && current.col == col2 && current.turns <= 2) {
-            return true;
-        }
-
-        for (int i = 0; i < 4; ++i) {
-            int newRow = current.row + directions[i][0];
-            int newCol = current.col + directions[i][1];
-            int newTurns = current.turns;
-            if (current.path.size() > 1) {
-                QPair<int, int> prev = current.path[current.path.size() - 2];
-                if (prev.first != newRow && prev.second != newCol) {
-                    newTurns++;
-                }
-            }
-
-            if (newTurns > 2) continue;
-
-            while (newRow >= 0 && newRow < mapData.size() && newCol >= 0 && newCol < mapData[0].size()) {
-                if (newRow == row2 && newCol == col2) {
-                    if (newTurns <= 2) {
-                        return true;
-                    }
-                    break;
-                }
-
-                if (mapData[newRow][newCol] != -1) {
-                    break;
-                }
-
-                if (!visited[newRow][newCol]) {
-                    visited[newRow][newCol] = true;
-                    Node newNode = {newRow, newCol, newTurns, current.path};
-                    newNode.path.emplace_back(newRow, newCol);
-                    q.push(newNode);
-                }
-
-                newRow += directions[i][0];
-                newCol += directions[i][1];
-            }
+    int numNodes = 10 * 16;
+    if (adjMatrix.size() == numNodes) {
+        for (QVector<bool> &row : adjMatrix) {
+            row.fill(false);
         }
+    } else {
+        adjMatrix.clear();
+        adjMatrix.resize(numNodes, QVector<bool>(numNodes, false));
     }
 
-    return false;
+    for (const llk_engine::Move &move : engine->moves()) {
+        adjMatrix[move.first][move.second] = true;
+        adjMatrix[move.second][move.first] = true;
+    }
 }
 
 bool basic_mode::canEliminate(const QPair<int, int> &pos1, const QPair<int, int> &pos2, QVector<QPair<int, int>> &path)
 {
-    if (pos1 == pos2) return false;
-    int row1 = pos1.first;
-    int col1 = pos1.second;
-    int row2 = pos2.first;
-    int col2 = pos2.second;
-    if (mapData[row1][col1] != mapData[row2][col2]) return false;
-
-    struct Node {
-        int row;
-        int col;
-        int turns;
-        QVector<QPair<int, int>> path;
-    };
-
-    std::queue<Node> q;
-    QVector<QVector<bool>> visited(mapData.size(), QVector<bool>(mapData[0].size(), false));
-    QVector<QVector<int>> directions = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
-
-    q.push({row1, col1, 0, {pos1}});
-    visited[row1][col1] = true;
-
-    while (!q.empty()) {
-        Node current = q.front();
-        q.pop();
-
-        if (current.row == row2 && current.col == col2 && current.turns <= 2) {
-            path = current.path;
-            path.emplace_back(row2, col2);
-            return true;
-        }
-
-        for (int i = 0; i < 4; ++i) {
-            int newRow = current.row + directions[i][0];
-            int newCol = current.col + directions[i][1];
-            int newTurns = current.turns;
-            if (current.path.size() > 1) {
-                QPair<int, int> prev = current.path[current.path.size() - 2];
-                if (prev.first != newRow && prev.second != newCol) {
-                    newTurns++;
-                }
-            }
-
-            if (newTurns > 2) continue;
-
-            while (newRow >= 0 && newRow < mapData.size() && newCol >= 0 && newCol < mapData[0].size()) {
-                if (newRow == row2 && newCol == col2) {
-                    if (newTurns <= 2) {
-                        path = current.path;
-                        path.emplace_back(newRow, newCol);
-                        return true;
-                    }
-                    break;
-                }
-
-                if (mapData[newRow][newCol] != -1) {
-                    break;
-                }
-
-                if (!visited[newRow][newCol]) {
-                    visited[newRow][newCol] = true;
-                    Node newNode = {newRow, newCol, newTurns, current.path};
-                    newNode.path.emplace_back(newRow, newCol);
-                    q.push(newNode);
-                }
-
-                newRow += directions[i][0];
-                newCol += directions[i][1];
-            }
-        }
+    std::vector<llk_engine::Point> corners;
+    if (!engine->canEliminate(pos1.first * 16 + pos1.second, pos2.first * 16 + pos2.second, &corners)) {
+        return false;
     }
-
-    return false;
+    path.clear();
+    for (const llk_engine::Point &corner : corners) {
+        path.emplace_back(corner.first, corner.second);
+    }
+    return true;
 }
 
 void basic_mode::eliminatePatterns(const QPair<int, int> &pos1, const QPair<int, int> &pos2)
 {
-    if (pos1.first >= 0 && pos1.first < mapData.size() && pos1.second >= 0 && pos1.second < mapData[0].size()) {
-        mapData[pos1.first][pos1.second] = -1;
-    }
-    if (pos2.first >= 0 && pos2.first < mapData.size() && pos2.second >= 0 && pos2.second < mapData[0].size()) {
-        mapData[pos2.first][pos2.second] = -1;
+    if (pos1.first < 0 || pos1.first >= mapData.size() || pos1.second < 0 || pos1.second >= mapData[0].size() ||
+        pos2.first < 0 || pos2.first >= mapData.size() || pos2.second < 0 || pos2.second >= mapData[0].size()) {
+        return;
     }
     score += 10;
-    buildAdjMatrix();
+    engine->eliminate(pos1.first * 16 + pos1.second, pos2.first * 16 + pos2.second);
+    syncMapData();
+    updateAdjMatrix();
+}
+
+// 从引擎读回棋盘，有重力时消除后图案会下落
+void basic_mode::syncMapData()
+{
+    for (int i = 0; i < 10; ++i) {
+        for (int j = 0; j < 16; ++j) {
+            mapData[i][j] = engine->cell(i * 16 + j);
+        }
+    }
 }
 
 void basic_mode::mousePressEvent(QMouseEvent *event)
@@ -513,4 +386,102 @@ void basic_mode::setButtonInteractions(bool enabled)
     ui->BTN_TIP->setEnabled(enabled);
     ui->BTN_REARRANGE->setEnabled(enabled);
     ui->BTN_PAUSE->setEnabled(enabled);
+    ui->BTN_AUTO->setEnabled(enabled);
+}
+
+void basic_mode::on_BTN_AUTO_clicked()
+{
+    if (isEliminating || mapData.isEmpty()) return;
+
+    isEliminating = true;
+    setButtonInteractions(false);
+    selectedPos1 = {-1, -1};
+    selectedPos2 = {-1, -1};
+    hintPos1 = {-1, -1};
+    hintPos2 = {-1, -1};
+    update();
+
+    solveCancelled = false;
+    const int round = autoPlayRound;
+    solveTask = std::async(std::launch::async, [this, round, board = engine->clone()]() {
+        QElapsedTimer timer;
+        timer.start();
+        solve_result result = llk_solver::solve(*board, 0, llk_solver::DefaultNodeBudget,
+                                                  llk_solver::DefaultTimeLimitMs, &solveCancelled);
+        qint64 elapsed = timer.elapsed();
+        QMetaObject::invokeMethod(this, [this, round, result, elapsed]() {
+            if (round == autoPlayRound) {
+                finishSolve(result, elapsed);
+            }
+        }, Qt::QueuedConnection);
+    });
+}
+
+void basic_mode::finishSolve(const solve_result &result, qint64 elapsed)
+{
+    game_resources::logPhase(QString("solver finished in %1 ms, status %2, %3 nodes, %4 moves")
+                                 .arg(elapsed)
+                                 .arg(result.status)
+                                 .arg(result.nodes)
+                                 .arg(result.moves.size()));
+    if (gameOver) {
+        stopAutoPlay();
+        return;
+    }
+
+    if (result.status == solve_result::Solved) {
+        autoMoves = QVector<llk_engine::Move>(result.moves.begin(), result.moves.end());
+        playNextAutoMove();
+    } else if (result.status == solve_result::Unsolvable) {
+        stopAutoPlay();
+        QMessageBox::information(this, "自动求解", "当前局面无解！请进行重排！");
+    } else {
+        stopAutoPlay();
+        QMessageBox::information(this, "自动求解", "未能在限定时间内求解当前局面！");
+    }
+}
+
+void basic_mode::playNextAutoMove()
+{
+    if (gameOver || autoMoves.isEmpty()) {
+        stopAutoPlay();
+        return;
+    }
+
+    llk_engine::Move move = autoMoves.takeFirst();
+    QPair<int, int> pos1 = {move.first / 16, move.first % 16};
+    QPair<int, int> pos2 = {move.second / 16, move.second % 16};
+    QVector<QPair<int, int>> path;
+    if (!canEliminate(pos1, pos2, path)) {
+        stopAutoPlay();
+        return;
+    }
+
+    selectedPos1 = pos1;
+    selectedPos2 = pos2;
+    connectionPath = path;
+    update();
+    QTimer::singleShot(300, this, [this, round = autoPlayRound, pos1, pos2]() {
+        if (round != autoPlayRound) return;
+        eliminatePatterns(pos1, pos2);
+        connectionPath.clear();
+        selectedPos1 = {-1, -1};
+        selectedPos2 = {-1, -1};
+        update();
+        playNextAutoMove();
+    });
+}
+
+void basic_mode::stopAutoPlay()
+{
+    ++autoPlayRound;
+    autoMoves.clear();
+    connectionPath.clear();
+    selectedPos1 = {-1, -1};
+    selectedPos2 = {-1, -1};
+    isEliminating = false;
+    if (!gameOver) {
+        setButtonInteractions(true);
+    }
+    update();
 }
@@ -10,6 +10,11 @@
 #include <QMessageBox>
 #include <QMouseEvent>
 #include <QTimer>
+#include <memory>
+#include <future>
+#include <atomic>
+#include "llk_engine.h"
+#include "llk_solver.h"
 
 
 // 开始 Qt 命名空间
@@ -23,7 +28,7 @@ class basic_mode : public QWidget
     Q_OBJECT
 
 public:
-    basic_mode(QWidget *parent = nullptr);
+    basic_mode(QWidget *parent = nullptr, const game_variant &variant = game_variant());
     ~basic_mode();
 
 private slots:
@@ -31,6 +36,7 @@ private slots:
     void on_BTN_PAUSE_clicked();
     void on_BTN_TIP_clicked();
     void on_BTN_REARRANGE_clicked();
+    void on_BTN_AUTO_clicked();
     void clearHint();
 
 protected:
@@ -41,8 +47,6 @@ protected:
 private:
     Ui::basic_mode *ui;
     QVector<QVector<int>> mapData;
-    QPixmap elementPixmap;
-    QPixmap maskPixmap;
     QVector<QPixmap> elements;
     QPixmap backgroundPixmap;
 
@@ -60,12 +64,18 @@ private:
     bool isEliminating = false;
 
     QVector<QVector<bool>> adjMatrix; // 邻接矩阵
+    std::unique_ptr<llk_engine> engine; // 规则引擎，与 mapData 保持同步
+
+    std::future<void> solveTask; // 后台求解任务
+    std::atomic<bool> solveCancelled{false};
+    QVector<llk_engine::Move> autoMoves; // 待自动执行的消除序列
+    int autoPlayRound = 0; // 每次停止自动求解时递增，用于丢弃上一轮尚未执行的回调
 
     void generateMap();
     void extractElements();
-    void shuffleMap();
     void buildAdjMatrix();
-    bool canEliminate(const QPair<int, int> &pos1, const QPair<int, int> &pos2);
+    void updateAdjMatrix();
+    void syncMapData();
     bool canEliminate(const QPair<int, int> &pos1, const QPair<int, int> &pos2, QVector<QPair<int, int>> &path);
     void eliminatePatterns(const QPair<int, int> &pos1, const QPair<int, int> &pos2);
 
@@ -74,5 +84,9 @@ private:
     void showLoseMessage();
 
     void setButtonInteractions(bool enabled);
+
+    void finishSolve(const solve_result &result, qint64 elapsed);
+    void playNextAutoMove();
+    void stopAutoPlay();
 };
 #endif // BASIC_MODE_H
@@ -0,0 +1,87 @@
+#include "difficulty_estimator.h"
+#include <algorithm>
+#include <thread>
+
+namespace {
+
+// 单个线程的统计结果
+struct Tally {
+    int cleared = 0;
+    long long rearranges = 0;
+    long long steps = 0;
+    long long moves = 0;
+};
+
+void playRollout(const llk_engine &board, unsigned seed, Tally &tally)
+{
+    std::unique_ptr<llk_engine> game = board.clone();
+    std::mt19937 rng(seed);
+    int rearranges = 0;
+
+    while (!game->cleared()) {
+        const std::vector<llk_engine::Move> &moves = game->moves();
+        if (moves.empty()) {
+            if (rearranges == difficulty_estimator::MaxRearranges) break;
+            game->rearrange(rng);
+            ++rearranges;
+            continue;
+        }
+        tally.moves += static_cast<long long>(moves.size());
+        ++tally.steps;
+        std::uniform_int_distribution<size_t> pick(0, moves.size() - 1);
+        const llk_engine::Move move = moves[pick(rng)];
+        game->eliminate(move.first, move.second);
+    }
+
+    if (game->cleared() && rearranges == 0) {
+        ++tally.cleared;
+    }
+    tally.rearranges += rearranges;
+}
+
+} // namespace
+
+difficulty_rating difficulty_estimator::rate(const llk_engine &board, int rollouts, int threads,
+                                             unsigned seed)
+{
+    difficulty_rating rating;
+    if (rollouts <= 0) return rating;
+
+    if (threads <= 0) {
+        threads = static_cast<int>(std::thread::hardware_concurrency());
+    }
+    threads = std::max(1, std::min(threads, rollouts));
+
+    std::vector<Tally> tallies(threads);
+    auto worker = [&](int first) {
+        // 先累加到线程内的局部变量，结束时再写回，避免相邻统计项的伪共享
+        Tally local;
+        for (int i = first; i < rollouts; i += threads) {
+            playRollout(board, seed + static_cast<unsigned>(i) * 2654435761u, local);
+        }
+        tallies[first] = local;
+    };
+
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads; ++t) {
+        pool.emplace_back(worker, t);
+    }
+    worker(0);
+    for (std::thread &thread : pool) {
+        thread.join();
+    }
+
+    Tally total;
+    for (const Tally &tally : tallies) {
+        total.cleared += tally.cleared;
+        total.rearranges += tally.rearranges;
+        total.steps += tally.steps;
+        total.moves += tally.moves;
+    }
+
+    rating.rollouts = rollouts;
+    rating.clearProbability = static_cast<double>(total.cleared) / rollouts;
+    rating.expectedRearranges = static_cast<double>(total.rearranges) / rollouts;
+    rating.averageMoves = total.steps ? static_cast<double>(total.moves) / total.steps : 0.0;
+    return rating;
+}
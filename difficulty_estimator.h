@@ -0,0 +1,30 @@
+#ifndef DIFFICULTY_ESTIMATOR_H
+#define DIFFICULTY_ESTIMATOR_H
+
+#include "llk_engine.h"
+
+// 棋盘难度评估结果
+struct difficulty_rating {
+    // 不重排、纯随机消除即可清空棋盘的概率
+    double clearProbability = 0.0;
+    // 随机消除直至清空平均需要的强制重排次数
+    double expectedRearranges = 0.0;
+    // 消除过程中每一步平均可选的消除对数
+    double averageMoves = 0.0;
+    int rollouts = 0;
+};
+
+// 蒙特卡洛难度评估：在多个线程上并行进行随机对局，统计结果
+// 每局使用由 seed 和局号确定的随机数，结果与线程数无关
+class difficulty_estimator
+{
+public:
+    // 单局中允许的最大重排次数，超过后视为无法清空
+    static constexpr int MaxRearranges = 20;
+
+    // threads 为 0 时使用硬件线程数
+    static difficulty_rating rate(const llk_engine &board, int rollouts = 64, int threads = 0,
+                                  unsigned seed = 0);
+};
+
+#endif // DIFFICULTY_ESTIMATOR_H
@@ -0,0 +1,216 @@
+#include "game_resources.h"
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QDebug>
+#include <future>
+#include <map>
+
+namespace {
+
+// 解码后的图集，QImage 可在后台线程安全构造
+struct Atlas {
+    QVector<QImage> elements;
+};
+
+QElapsedTimer startupClock;
+std::shared_future<QImage> backgroundFuture;
+std::shared_future<Atlas> atlasFuture;
+// 按规则变体分别保存的预生成棋盘，已提交的任务不会被丢弃，避免析构时阻塞等待
+std::map<int, std::shared_future<game_resources::Board>> boardFutures;
+
+int variantKey(const game_variant &variant)
+{
+    return variant.maxTurns * 4 + (variant.wraparound ? 2 : 0) + (variant.gravity ? 1 : 0);
+}
+
+QImage loadBackground()
+{
+    QElapsedTimer timer;
+    timer.start();
+    QImage image(":/resource/fruit_b0g.bmp");
+    game_resources::logPhase(QString("background decoded in %1 ms").arg(timer.elapsed()));
+    return image;
+}
+
+// 掩码图中为黑色的像素置为透明，效果等同于 QPixmap::setMask(createMaskFromColor(Qt::black))
+Atlas loadAtlas()
+{
+    QElapsedTimer timer;
+    timer.start();
+    QImage elementImage = QImage(":/resource/fruit_element.bmp").convertToFormat(QImage::Format_ARGB32);
+    QImage maskImage = QImage(":/resource/fruit_mask.bmp").convertToFormat(QImage::Format_RGB32);
+
+    Atlas atlas;
+    for (int i = 0; i < game_resources::ElementCount; ++i) {
+        QImage element = elementImage.copy(0, i * 40, 40, 40);
+        QImage mask = maskImage.copy(0, i * 40, 40, 40);
+        for (int y = 0; y < element.height() && y < mask.height(); ++y) {
+            QRgb *line = reinterpret_cast<QRgb *>(element.scanLine(y));
+            const QRgb *maskLine = reinterpret_cast<const QRgb *>(mask.constScanLine(y));
+            for (int x = 0; x < element.width() && x < mask.width(); ++x) {
+                if ((maskLine[x] & 0x00FFFFFF) == 0) {
+                    line[x] = 0;
+                }
+            }
+        }
+        atlas.elements.append(element);
+    }
+    game_resources::logPhase(QString("element atlas decoded in %1 ms").arg(timer.elapsed()));
+    return atlas;
+}
+
+game_resources::Board prepareBoard(game_variant variant)
+{
+    QElapsedTimer timer;
+    timer.start();
+    const int numNodes = game_resources::Rows * game_resources::Cols;
+    game_resources::Board board;
+    board.mapData = game_resources::generateRatedMap(game_resources::ElementCount, variant, &board.rating);
+    board.adjMatrix.resize(numNodes, QVector<bool>(numNodes, false));
+    game_resources::logPhase(QString("board prepared in %1 ms for %2 turns%3%4 (clear %5, rearranges %6, moves %7)")
+                                 .arg(timer.elapsed())
+                                 .arg(variant.maxTurns)
+                                 .arg(variant.wraparound ? ", wraparound" : "")
+                                 .arg(variant.gravity ? ", gravity" : "")
+                                 .arg(board.rating.clearProbability, 0, 'f', 2)
+                                 .arg(board.rating.expectedRearranges, 0, 'f', 2)
+                                 .arg(board.rating.averageMoves, 0, 'f', 1));
+    return board;
+}
+
+// 等待后台任务完成，若发生阻塞则记录等待时间
+template <typename T>
+T waitFor(const std::shared_future<T> &future, const char *name)
+{
+    if (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        QElapsedTimer timer;
+        timer.start();
+        future.wait();
+        game_resources::logPhase(QString("waited %1 ms for %2").arg(timer.elapsed()).arg(name));
+    }
+    return future.get();
+}
+
+} // namespace
+
+void game_resources::startClock()
+{
+    if (!startupClock.isValid()) {
+        startupClock.start();
+    }
+}
+
+void game_resources::preload()
+{
+    if (backgroundFuture.valid()) {
+        return;
+    }
+    startClock();
+    logPhase("preload started");
+    backgroundFuture = std::async(std::launch::async, loadBackground).share();
+    atlasFuture = std::async(std::launch::async, loadAtlas).share();
+    requestBoard(game_variant());
+}
+
+void game_resources::requestBoard(const game_variant &variant)
+{
+    std::shared_future<Board> &future = boardFutures[variantKey(variant)];
+    if (!future.valid()) {
+        future = std::async(std::launch::async, prepareBoard, variant).share();
+    }
+}
+
+QPixmap game_resources::background()
+{
+    preload();
+    return QPixmap::fromImage(waitFor(backgroundFuture, "background"));
+}
+
+QVector<QPixmap> game_resources::elements()
+{
+    preload();
+    QVector<QPixmap> pixmaps;
+    for (const QImage &image : waitFor(atlasFuture, "element atlas").elements) {
+        pixmaps.append(QPixmap::fromImage(image));
+    }
+    return pixmaps;
+}
+
+game_resources::Board game_resources::takeBoard(const game_variant &variant)
+{
+    preload();
+    requestBoard(variant);
+    std::shared_future<Board> &future = boardFutures[variantKey(variant)];
+    Board board = waitFor(future, "board");
+    future = std::async(std::launch::async, prepareBoard, variant).share();
+    return board;
+}
+
+QVector<QVector<int>> game_resources::generateMap(int elementCount)
+{
+    QVector<QVector<int>> mapData(Rows, QVector<int>(Cols, -1));
+
+    int elementIndex = 0;
+    for (int i = 0; i < Rows; ++i) {
+        for (int j = 0; j < Cols; j += 2) {
+            mapData[i][j] = elementIndex;
+            mapData[i][j + 1] = elementIndex;
+            elementIndex = (elementIndex + 1) % elementCount;
+        }
+    }
+
+    const int shuffleTimes = 100;
+    for (int i = 0; i < shuffleTimes; ++i) {
+        int row1 = QRandomGenerator::global()->bounded(Rows);
+        int col1 = QRandomGenerator::global()->bounded(Cols);
+        int row2 = QRandomGenerator::global()->bounded(Rows);
+        int col2 = QRandomGenerator::global()->bounded(Cols);
+
+        int temp = mapData[row1][col1];
+        mapData[row1][col1] = mapData[row2][col2];
+        mapData[row2][col2] = temp;
+    }
+
+    return mapData;
+}
+
+QVector<QVector<int>> game_resources::generateRatedMap(int elementCount, const game_variant &variant,
+                                                       difficulty_rating *rating)
+{
+    QVector<QVector<int>> best;
+    difficulty_rating bestRating;
+    double bestDistance = 2.0;
+
+    for (int attempt = 0; attempt < MaxBoardCandidates; ++attempt) {
+        QVector<QVector<int>> candidate = generateMap(elementCount);
+        std::vector<int> cells;
+        cells.reserve(Rows * Cols);
+        for (const QVector<int> &row : candidate) {
+            cells.insert(cells.end(), row.begin(), row.end());
+        }
+        std::unique_ptr<llk_engine> board = llk_engine::create(variant, Rows, Cols);
+        board->load(cells);
+        difficulty_rating candidateRating =
+            difficulty_estimator::rate(*board, 64, 0, QRandomGenerator::global()->generate());
+
+        double distance = qAbs(candidateRating.clearProbability - TargetClearProbability);
+        if (distance < bestDistance) {
+            best = candidate;
+            bestRating = candidateRating;
+            bestDistance = distance;
+        }
+        if (distance <= ClearProbabilityTolerance) {
+            break;
+        }
+    }
+
+    if (rating) {
+        *rating = bestRating;
+    }
+    return best;
+}
+
+void game_resources::logPhase(const QString &phase)
+{
+    qInfo().noquote() << QString("[startup +%1 ms] %2").arg(startupClock.elapsed()).arg(phase);
+}
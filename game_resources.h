@@ -0,0 +1,55 @@
+#ifndef GAME_RESOURCES_H
+#define GAME_RESOURCES_H
+
+#include <QImage>
+#include <QPixmap>
+#include <QVector>
+#include <QString>
+#include "difficulty_estimator.h"
+
+// 游戏资源预加载
+// 主菜单显示后即在后台线程解码背景图、图案/掩码图集，并预先生成第一局的棋盘，
+// 打开游戏窗口时只需等待尚未就绪的那部分数据
+// 棋盘按所属规则变体生成，并在该规则下经蒙特卡洛评估难度，只提供难度接近目标的棋盘
+class game_resources
+{
+public:
+    static constexpr int Rows = 10;
+    static constexpr int Cols = 16;
+    static constexpr int ElementCount = 20;
+    // 目标难度：纯随机消除的清空概率及允许偏差
+    static constexpr double TargetClearProbability = 0.9;
+    static constexpr double ClearProbabilityTolerance = 0.1;
+    // 每次最多生成并评估的候选棋盘数
+    static constexpr int MaxBoardCandidates = 8;
+
+    // 预生成的棋盘及其邻接矩阵缓冲区
+    struct Board {
+        QVector<QVector<int>> mapData;
+        QVector<QVector<bool>> adjMatrix;
+        difficulty_rating rating;
+    };
+
+    // 启动计时，应在 main 中最先调用
+    static void startClock();
+    // 启动后台预加载（重复调用无副作用），预生成的是基础模式的棋盘
+    static void preload();
+    // 在后台为指定规则变体准备棋盘（已在准备时无副作用）
+    static void requestBoard(const game_variant &variant);
+
+    // 以下接口在对应数据未就绪时阻塞等待，必须在 GUI 线程调用
+    static QPixmap background();
+    static QVector<QPixmap> elements();
+    // 取走为该规则变体预生成的棋盘，并在后台准备下一局
+    static Board takeBoard(const game_variant &variant);
+
+    // 按顺序填充成对图案后随机打乱，生成一局棋盘
+    static QVector<QVector<int>> generateMap(int elementCount);
+    // 生成若干候选棋盘并在指定规则下评估，返回难度最接近目标的一个
+    static QVector<QVector<int>> generateRatedMap(int elementCount, const game_variant &variant,
+                                                  difficulty_rating *rating = nullptr);
+    // 输出启动阶段耗时日志
+    static void logPhase(const QString &phase);
+};
+
+#endif // GAME_RESOURCES_H
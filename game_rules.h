@@ -0,0 +1,82 @@
+#ifndef GAME_RULES_H
+#define GAME_RULES_H
+
+#include <vector>
+
+// 编译期规则策略，组合后作为 rule_engine 的模板参数
+// 每种组合都会生成专门的匹配与邻接更新代码，热循环中不做规则判断
+
+// 边界策略：直线走出棋盘即终止
+struct bounded_edges {
+    static constexpr bool Wraparound = false;
+
+    // 沿方向前进一格，越界时返回 false
+    static bool advance(int &row, int &col, int dRow, int dCol, int rows, int cols)
+    {
+        row += dRow;
+        col += dCol;
+        return row >= 0 && row < rows && col >= 0 && col < cols;
+    }
+};
+
+// 边界策略：直线从一侧走出后从对侧回到棋盘
+struct wrapped_edges {
+    static constexpr bool Wraparound = true;
+
+    static bool advance(int &row, int &col, int dRow, int dCol, int rows, int cols)
+    {
+        row += dRow;
+        col += dCol;
+        if (row < 0) row += rows; else if (row >= rows) row -= rows;
+        if (col < 0) col += cols; else if (col >= cols) col -= cols;
+        return true;
+    }
+};
+
+// 重力策略：消除后图案保持原位
+struct no_gravity {
+    static constexpr bool MovesTiles = false;
+
+    static void settle(std::vector<int> &, int, int, int) {}
+};
+
+// 重力策略：消除后同列上方的图案下落填补空位
+struct falling_gravity {
+    static constexpr bool MovesTiles = true;
+
+    static void settle(std::vector<int> &cells, int rows, int cols, int column)
+    {
+        int target = rows - 1;
+        for (int row = rows - 1; row >= 0; --row) {
+            const int value = cells[row * cols + column];
+            if (value != -1) {
+                cells[target * cols + column] = value;
+                --target;
+            }
+        }
+        for (; target >= 0; --target) {
+            cells[target * cols + column] = -1;
+        }
+    }
+};
+
+// 规则组合：最大拐弯次数、边界策略、重力策略
+template <int Turns, typename Edges = bounded_edges, typename Gravity = no_gravity>
+struct game_rules {
+    static_assert(Turns >= 0, "Turns must not be negative");
+    static constexpr int MaxTurns = Turns;
+    using edges = Edges;
+    using gravity = Gravity;
+};
+
+// 基础模式规则：最多两次拐弯，不穿越边界，无重力
+using classic_rules = game_rules<2>;
+
+// 规则变体的运行时描述，由 llk_engine::create 映射到对应的编译期规则
+struct game_variant {
+    int maxTurns = 2; // 支持 1、2、3
+    bool wraparound = false;
+    bool gravity = false;
+};
+
+#endif // GAME_RULES_H
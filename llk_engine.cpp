@@ -0,0 +1,154 @@
+#include "llk_engine.h"
+
+namespace {
+
+template <int Turns, typename Edges>
+std::unique_ptr<llk_engine> createWithGravity(bool gravity, int rows, int cols)
+{
+    if (gravity) {
+        return std::make_unique<rule_engine<game_rules<Turns, Edges, falling_gravity>>>(rows, cols);
+    }
+    return std::make_unique<rule_engine<game_rules<Turns, Edges, no_gravity>>>(rows, cols);
+}
+
+template <int Turns>
+std::unique_ptr<llk_engine> createWithEdges(const game_variant &variant, int rows, int cols)
+{
+    if (variant.wraparound) {
+        return createWithGravity<Turns, wrapped_edges>(variant.gravity, rows, cols);
+    }
+    return createWithGravity<Turns, bounded_edges>(variant.gravity, rows, cols);
+}
+
+} // namespace
+
+llk_engine::llk_engine(int rows, int cols)
+    : rowCount(rows)
+    , colCount(cols)
+    , cellCount(rows * cols)
+    , remainingCount(0)
+    , cells(rows * cols, -1)
+    , adjacency(rows * cols * rows * cols, 0)
+{
+}
+
+std::unique_ptr<llk_engine> llk_engine::create(const game_variant &variant, int rows, int cols)
+{
+    switch (variant.maxTurns) {
+    case 1:
+        return createWithEdges<1>(variant, rows, cols);
+    case 3:
+        return createWithEdges<3>(variant, rows, cols);
+    default:
+        return createWithEdges<2>(variant, rows, cols);
+    }
+}
+
+void llk_engine::load(const std::vector<int> &newCells)
+{
+    cells = newCells;
+    cells.resize(cellCount, -1);
+    undoDepth = 0;
+    moveChanges.clear();
+    remainingCount = 0;
+    for (int value : cells) {
+        if (value != -1) {
+            ++remainingCount;
+        }
+    }
+    rebuildMoves();
+}
+
+void llk_engine::addMove(int from, int to)
+{
+    if (from > to) std::swap(from, to);
+    if (adjacency[from * cellCount + to]) return;
+    adjacency[from * cellCount + to] = 1;
+    adjacency[to * cellCount + from] = 1;
+    moveList.emplace_back(from, to);
+    if (undoDepth > 0) {
+        moveChanges.push_back({moveList.back(), -1});
+    }
+}
+
+void llk_engine::removeMove(size_t position)
+{
+    const Move move = moveList[position];
+    if (undoDepth > 0) {
+        moveChanges.push_back({move, static_cast<int>(position)});
+    }
+    adjacency[move.first * cellCount + move.second] = 0;
+    adjacency[move.second * cellCount + move.first] = 0;
+    moveList[position] = moveList.back();
+    moveList.pop_back();
+}
+
+void llk_engine::rearrange(std::mt19937 &rng)
+{
+    std::vector<int> occupied;
+    std::vector<int> values;
+    for (int index = 0; index < cellCount; ++index) {
+        if (cells[index] != -1) {
+            occupied.push_back(index);
+            values.push_back(cells[index]);
+        }
+    }
+    std::shuffle(values.begin(), values.end(), rng);
+    for (size_t i = 0; i < occupied.size(); ++i) {
+        cells[occupied[i]] = values[i];
+    }
+    undoDepth = 0;
+    moveChanges.clear();
+    rebuildMoves();
+}
+
+void llk_engine::setUndoEnabled(bool enabled)
+{
+    undoEnabled = enabled;
+    undoDepth = 0;
+    moveChanges.clear();
+}
+
+void llk_engine::beginUndoFrame()
+{
+    if (!undoEnabled) return;
+    if (undoDepth == undoFrames.size()) {
+        undoFrames.emplace_back();
+    }
+    UndoFrame &frame = undoFrames[undoDepth++];
+    frame.cells = cells;
+    frame.remainingCount = remainingCount;
+    frame.changeStart = moveChanges.size();
+}
+
+// 按相反顺序回放可消除图案对的变化：
+// 新增的图案对此时必在末尾；被移除的图案对放回原位，原位上的图案对移回末尾
+void llk_engine::undo()
+{
+    if (undoDepth == 0) return;
+    const UndoFrame &frame = undoFrames[--undoDepth];
+
+    while (moveChanges.size() > frame.changeStart) {
+        const MoveChange change = moveChanges.back();
+        moveChanges.pop_back();
+        const Move &move = change.move;
+        if (change.position < 0) {
+            moveList.pop_back();
+            adjacency[move.first * cellCount + move.second] = 0;
+            adjacency[move.second * cellCount + move.first] = 0;
+        } else {
+            const size_t position = static_cast<size_t>(change.position);
+            if (position == moveList.size()) {
+                moveList.push_back(move);
+            } else {
+                moveList.push_back(moveList[position]);
+                moveList[position] = move;
+            }
+            adjacency[move.first * cellCount + move.second] = 1;
+            adjacency[move.second * cellCount + move.first] = 1;
+        }
+    }
+
+    cells = frame.cells;
+    remainingCount = frame.remainingCount;
+}
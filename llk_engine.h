@@ -0,0 +1,409 @@
+#ifndef LLK_ENGINE_H
+#define LLK_ENGINE_H
+
+#include <vector>
+#include <random>
+#include <memory>
+#include <utility>
+#include <algorithm>
+#include "game_rules.h"
+
+// 连连看规则引擎（不依赖界面，可在后台线程使用）
+// 棋盘按行优先展开为一维数组，格子编号为 row * cols + col，-1 表示空格
+// 引擎维护当前所有可消除的图案对，消除后只重新检查受影响的图案
+// 具体规则由 rule_engine<Rules> 在编译期确定，本类只提供按变体创建和逐次操作的接口
+class llk_engine
+{
+public:
+    using Move = std::pair<int, int>;
+    // 连线上的点 (row, col)，穿越边界时会出现棋盘外的坐标
+    using Point = std::pair<int, int>;
+
+    virtual ~llk_engine() = default;
+
+    // 按规则变体创建引擎
+    static std::unique_ptr<llk_engine> create(const game_variant &variant, int rows = 10, int cols = 16);
+    virtual std::unique_ptr<llk_engine> clone() const = 0;
+
+    // 载入棋盘并重建可消除图案对
+    void load(const std::vector<int> &cells);
+
+    int rows() const { return rowCount; }
+    int cols() const { return colCount; }
+    int cell(int index) const { return cells[index]; }
+    const std::vector<int> &board() const { return cells; }
+    int remaining() const { return remainingCount; }
+    bool cleared() const { return remainingCount == 0; }
+    // 消除后图案是否会移动（重力规则）
+    virtual bool movesTiles() const = 0;
+    // 引擎对应的规则变体
+    virtual game_variant variant() const = 0;
+
+    // 判断两个图案能否消除，path 非空时输出连线的拐点序列（含两端）
+    virtual bool canEliminate(int from, int to, std::vector<Point> *path = nullptr) const = 0;
+    // 当前所有可消除的图案对，每对只出现一次且 first < second
+    const std::vector<Move> &moves() const { return moveList; }
+    bool isMove(int from, int to) const { return adjacency[from * cellCount + to] != 0; }
+
+    // 消除一对图案并增量更新可消除图案对（有重力时图案会移动，需重新读取棋盘）
+    virtual void eliminate(int from, int to) = 0;
+    // 打乱剩余图案并重建可消除图案对
+    void rearrange(std::mt19937 &rng);
+
+    // 开启后每次 eliminate 都会记录撤销信息，供搜索时逐层回退而不必复制引擎
+    // load 和 rearrange 会清空撤销记录
+    void setUndoEnabled(bool enabled);
+    // 撤销最近一次 eliminate
+    void undo();
+
+protected:
+    static constexpr int DirectionRows[4] = {-1, 1, 0, 0};
+    static constexpr int DirectionCols[4] = {0, 0, -1, 1};
+
+    int rowCount;
+    int colCount;
+    int cellCount;
+    int remainingCount;
+    std::vector<int> cells;
+
+    std::vector<Move> moveList;
+    std::vector<unsigned char> adjacency;
+
+    llk_engine(int rows, int cols);
+
+    // 在 eliminate 修改棋盘前调用，开启撤销时保存当前棋盘
+    void beginUndoFrame();
+
+    virtual void rebuildMoves() = 0;
+    void addMove(int from, int to);
+    void removeMove(size_t position);
+
+private:
+    // 可消除图案对的一次变化，position 为 -1 表示新增，否则为被移除时的位置
+    struct MoveChange {
+        Move move;
+        int position;
+    };
+
+    // 一次 eliminate 的撤销信息，frames 只增不减以复用已分配的内存
+    struct UndoFrame {
+        std::vector<int> cells;
+        int remainingCount;
+        size_t changeStart;
+    };
+
+    bool undoEnabled = false;
+    size_t undoDepth = 0;
+    std::vector<UndoFrame> undoFrames;
+    std::vector<MoveChange> moveChanges;
+};
+
+// 按规则 Rules 特化的引擎
+template <typename Rules>
+class rule_engine final : public llk_engine
+{
+public:
+    explicit rule_engine(int rows = 10, int cols = 16);
+
+    std::unique_ptr<llk_engine> clone() const override { return std::make_unique<rule_engine>(*this); }
+    bool movesTiles() const override { return Rules::gravity::MovesTiles; }
+    game_variant variant() const override
+    {
+        return {Rules::MaxTurns, Rules::edges::Wraparound, Rules::gravity::MovesTiles};
+    }
+    bool canEliminate(int from, int to, std::vector<Point> *path = nullptr) const override;
+    void eliminate(int from, int to) override;
+
+protected:
+    void rebuildMoves() override;
+
+private:
+    // 搜索用的缓冲区，按 stamp 区分每次搜索，避免反复清零
+    mutable unsigned stamp;
+    mutable std::vector<unsigned> seen;
+    mutable std::vector<unsigned> hitSeen;
+    mutable std::vector<int> turns;
+    mutable std::vector<int> parent;
+    mutable std::vector<signed char> arrival;
+    mutable std::vector<int> queue;
+    mutable std::vector<int> hits;
+
+    // 增量更新用的缓冲区
+    std::vector<int> previous;
+    std::vector<int> changed;
+    std::vector<int> suspects;
+    std::vector<std::pair<int, int>> candidates;
+    std::vector<unsigned char> changedFlag;
+    std::vector<unsigned char> suspectFlag;
+
+    bool flood(int source, int target) const;
+    void collectHits(int source, std::vector<int> &out) const;
+    void checkThrough(int freed);
+};
+
+template <typename Rules>
+rule_engine<Rules>::rule_engine(int rows, int cols)
+    : llk_engine(rows, cols)
+    , stamp(0)
+    , seen(rows * cols, 0)
+    , hitSeen(rows * cols, 0)
+    , turns(rows * cols, 0)
+    , parent(rows * cols, -1)
+    , arrival(rows * cols, 0)
+    , changedFlag(rows * cols, 0)
+    , suspectFlag(rows * cols, 0)
+{
+    queue.reserve(cellCount);
+    hits.reserve(cellCount);
+    candidates.reserve(cellCount);
+}
+
+// 从 source 出发按拐弯次数逐层发射直线，记录直线碰到的图案
+// source 为图案时只收集同类图案，为空格时收集所有图案
+// 命中 target 时立即返回 true，此时 parent 链即为连线的拐点
+template <typename Rules>
+bool rule_engine<Rules>::flood(int source, int target) const
+{
+    if (++stamp == 0) {
+        std::fill(seen.begin(), seen.end(), 0);
+        std::fill(hitSeen.begin(), hitSeen.end(), 0);
+        stamp = 1;
+    }
+    queue.clear();
+    hits.clear();
+
+    const int type = cells[source];
+    seen[source] = stamp;
+    turns[source] = -1;
+    parent[source] = -1;
+    queue.push_back(source);
+
+    for (size_t head = 0; head < queue.size(); ++head) {
+        const int origin = queue[head];
+        const int layer = turns[origin] + 1;
+        if (layer > Rules::MaxTurns) {
+            break;
+        }
+        const int originRow = origin / colCount;
+        const int originCol = origin % colCount;
+        for (int d = 0; d < 4; ++d) {
+            const int length = DirectionRows[d] ? rowCount : colCount;
+            int row = originRow;
+            int col = originCol;
+            for (int step = 1; step < length; ++step) {
+                if (!Rules::edges::advance(row, col, DirectionRows[d], DirectionCols[d], rowCount, colCount)) {
+                    break;
+                }
+                const int index = row * colCount + col;
+                if (cells[index] != -1) {
+                    if (index != source && hitSeen[index] != stamp) {
+                        hitSeen[index] = stamp;
+                        turns[index] = layer;
+                        parent[index] = origin;
+                        arrival[index] = static_cast<signed char>(d);
+                        if (type == -1 || cells[index] == type) {
+                            if (index == target) {
+                                return true;
+                            }
+                            hits.push_back(index);
+                        }
+                    }
+                    break;
+                }
+                if (seen[index] != stamp) {
+                    seen[index] = stamp;
+                    turns[index] = layer;
+                    parent[index] = origin;
+                    arrival[index] = static_cast<signed char>(d);
+                    queue.push_back(index);
+                }
+            }
+        }
+    }
+    return false;
+}
+
+template <typename Rules>
+void rule_engine<Rules>::collectHits(int source, std::vector<int> &out) const
+{
+    flood(source, -1);
+    out.insert(out.end(), hits.begin(), hits.end());
+}
+
+template <typename Rules>
+bool rule_engine<Rules>::canEliminate(int from, int to, std::vector<Point> *path) const
+{
+    if (from == to || from < 0 || to < 0 || from >= cellCount || to >= cellCount) return false;
+    if (cells[from] == -1 || cells[from] != cells[to]) return false;
+    if (!flood(from, to)) return false;
+
+    if (path) {
+        path->clear();
+        for (int index = to; index != -1; index = parent[index]) {
+            const int row = index / colCount;
+            const int col = index % colCount;
+            path->emplace_back(row, col);
+            const int origin = parent[index];
+            if constexpr (Rules::edges::Wraparound) {
+                // 直线穿越边界时补上两侧的界外点，绘制时两点之间不连线
+                if (origin != -1) {
+                    const int d = arrival[index];
+                    const int originRow = origin / colCount;
+                    const int originCol = origin % colCount;
+                    if (DirectionRows[d] > 0 && row < originRow) {
+                        path->emplace_back(-1, col);
+                        path->emplace_back(rowCount, col);
+                    } else if (DirectionRows[d] < 0 && row > originRow) {
+                        path->emplace_back(rowCount, col);
+                        path->emplace_back(-1, col);
+                    } else if (DirectionCols[d] > 0 && col < originCol) {
+                        path->emplace_back(row, -1);
+                        path->emplace_back(row, colCount);
+                    } else if (DirectionCols[d] < 0 && col > originCol) {
+                        path->emplace_back(row, colCount);
+                        path->emplace_back(row, -1);
+                    }
+                }
+            }
+        }
+        std::reverse(path->begin(), path->end());
+    }
+    return true;
+}
+
+template <typename Rules>
+void rule_engine<Rules>::rebuildMoves()
+{
+    std::fill(adjacency.begin(), adjacency.end(), 0);
+    moveList.clear();
+    for (int index = 0; index < cellCount; ++index) {
+        if (cells[index] == -1) continue;
+        flood(index, -1);
+        for (int hit : hits) {
+            if (hit > index) {
+                addMove(index, hit);
+            }
+        }
+    }
+}
+
+// 检查连线经过空格 freed 的新图案对
+// 连线在 freed 处分为两段，两段的拐弯次数之和不超过上限，
+// 因此只需检查从 freed 出发的拐弯次数之和不超过上限的同类图案
+template <typename Rules>
+void rule_engine<Rules>::checkThrough(int freed)
+{
+    flood(freed, -1);
+    candidates.clear();
+    for (int hit : hits) {
+        candidates.emplace_back(hit, turns[hit]);
+    }
+    std::sort(candidates.begin(), candidates.end(),
+              [this](const std::pair<int, int> &a, const std::pair<int, int> &b) {
+                  return cells[a.first] < cells[b.first];
+              });
+
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        for (size_t j = i + 1; j < candidates.size() && cells[candidates[j].first] == cells[candidates[i].first]; ++j) {
+            const int first = candidates[i].first;
+            const int second = candidates[j].first;
+            if (candidates[i].second + candidates[j].second <= Rules::MaxTurns
+                && !isMove(first, second) && flood(first, second)) {
+                addMove(first, second);
+            }
+        }
+    }
+}
+
+// 可消除性只可能在以下图案对上发生变化：
+// 1. 一端所在格子的内容发生了变化（被消除或因重力移动）；
+// 2. 连线经过了被清空的格子，两端都能从该格子在拐弯限制内直线到达；
+// 3. 原连线经过的空格被下落的图案占据，两端在变化前都能从该格子直线到达。
+// 因此只需重新检查这几类图案，而不必重建全部图案对
+template <typename Rules>
+void rule_engine<Rules>::eliminate(int from, int to)
+{
+    beginUndoFrame();
+    if constexpr (Rules::gravity::MovesTiles) {
+        previous = cells;
+    }
+
+    changed.clear();
+    for (int index : {from, to}) {
+        if (index < 0 || index >= cellCount || cells[index] == -1) continue;
+        cells[index] = -1;
+        --remainingCount;
+        changed.push_back(index);
+    }
+
+    if constexpr (Rules::gravity::MovesTiles) {
+        std::vector<int> columns;
+        for (int index : changed) {
+            columns.push_back(index % colCount);
+        }
+        std::sort(columns.begin(), columns.end());
+        columns.erase(std::unique(columns.begin(), columns.end()), columns.end());
+
+        changed.clear();
+        for (int column : columns) {
+            Rules::gravity::settle(cells, rowCount, colCount, column);
+            for (int row = 0; row < rowCount; ++row) {
+                const int index = row * colCount + column;
+                if (cells[index] != previous[index]) {
+                    changed.push_back(index);
+                }
+            }
+        }
+
+        // 在变化前的棋盘上，从之后被占据的空格出发收集可能失效的图案对端点
+        suspects.clear();
+        cells.swap(previous);
+        for (int index : changed) {
+            if (cells[index] == -1 && previous[index] != -1) {
+                collectHits(index, suspects);
+            }
+        }
+        cells.swap(previous);
+        for (int index : suspects) {
+            suspectFlag[index] = 1;
+        }
+    }
+
+    for (int index : changed) {
+        changedFlag[index] = 1;
+    }
+
+    for (size_t i = 0; i < moveList.size();) {
+        const Move move = moveList[i];
+        if (changedFlag[move.first] || changedFlag[move.second]) {
+            removeMove(i);
+        } else if (Rules::gravity::MovesTiles && suspectFlag[move.first] && suspectFlag[move.second]
+                   && !flood(move.first, move.second)) {
+            removeMove(i);
+        } else {
+            ++i;
+        }
+    }
+
+    for (int index : changed) {
+        if (cells[index] == -1) {
+            checkThrough(index);
+        } else {
+            flood(index, -1);
+            for (int hit : hits) {
+                addMove(index, hit);
+            }
+        }
+    }
+
+    for (int index : changed) {
+        changedFlag[index] = 0;
+    }
+    if constexpr (Rules::gravity::MovesTiles) {
+        for (int index : suspects) {
+            suspectFlag[index] = 0;
+        }
+    }
+}
+
+#endif // LLK_ENGINE_H
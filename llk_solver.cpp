@@ -0,0 +1,244 @@
+#include "llk_solver.h"
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+
+namespace {
+
+const int TableShards = 64;
+
+// 已证明无解局面的哈希表，按分片加锁以减少线程间竞争
+class dead_table
+{
+public:
+    bool contains(std::uint64_t hash)
+    {
+        Shard &shard = shards[hash % TableShards];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        return shard.hashes.count(hash) != 0;
+    }
+
+    void insert(std::uint64_t hash)
+    {
+        Shard &shard = shards[hash % TableShards];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.hashes.insert(hash);
+    }
+
+private:
+    struct Shard {
+        std::mutex mutex;
+        std::unordered_set<std::uint64_t> hashes;
+    };
+    Shard shards[TableShards];
+};
+
+// 各线程共享的搜索状态
+struct search_context {
+    dead_table dead;
+    std::atomic<bool> found{false};
+    std::atomic<bool> exhausted{false};
+    std::atomic<long long> nodes{0};
+    long long budget = 0;
+    std::chrono::steady_clock::time_point deadline;
+    const std::atomic<bool> *cancel = nullptr;
+    std::mutex solutionMutex;
+    std::vector<llk_engine::Move> solution;
+
+    bool aborted() const { return found || exhausted || (cancel && *cancel); }
+
+    // 计入一个搜索节点，超出节点上限或时间上限时返回 false
+    bool countNode()
+    {
+        const long long count = nodes.fetch_add(1);
+        if (count >= budget || ((count & 255) == 0 && std::chrono::steady_clock::now() >= deadline)) {
+            exhausted = true;
+            return false;
+        }
+        return true;
+    }
+};
+
+std::uint64_t mix(std::uint64_t value)
+{
+    value += 0x9E3779B97F4A7C15ull;
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+    return value ^ (value >> 31);
+}
+
+// 按格子和图案异或得到局面哈希
+std::uint64_t boardHash(const llk_engine &engine)
+{
+    const std::vector<int> &cells = engine.board();
+    std::uint64_t hash = 0;
+    for (size_t index = 0; index < cells.size(); ++index) {
+        if (cells[index] != -1) {
+            hash ^= mix(index * 4096 + static_cast<std::uint64_t>(cells[index]));
+        }
+    }
+    return hash;
+}
+
+// 候选消除对：剩余数量少的图案优先
+// 无重力时消除只会让格子变空，若某类图案只剩最后一对且可消除，
+// 先消除它不会让任何解失效，因此只返回这一步
+void orderedMoves(const llk_engine &engine, std::vector<int> &counts, std::vector<llk_engine::Move> &moves)
+{
+    const std::vector<int> &cells = engine.board();
+    std::fill(counts.begin(), counts.end(), 0);
+    for (int value : cells) {
+        if (value == -1) continue;
+        if (value >= static_cast<int>(counts.size())) {
+            counts.resize(value + 1, 0);
+        }
+        ++counts[value];
+    }
+
+    moves.clear();
+    if (!engine.movesTiles()) {
+        for (const llk_engine::Move &move : engine.moves()) {
+            if (counts[cells[move.first]] == 2) {
+                moves.push_back(move);
+                return;
+            }
+        }
+    }
+    moves = engine.moves();
+    std::stable_sort(moves.begin(), moves.end(),
+                     [&](const llk_engine::Move &a, const llk_engine::Move &b) {
+                         return counts[cells[a.first]] < counts[cells[b.first]];
+                     });
+}
+
+// 单个线程的搜索状态：在一个引擎上逐层消除、回退，不复制引擎
+class searcher
+{
+public:
+    searcher(const llk_engine &board, search_context &context)
+        : engine(board.clone())
+        , context(context)
+    {
+        engine->setUndoEnabled(true);
+    }
+
+    llk_engine &board() { return *engine; }
+    std::vector<llk_engine::Move> path;
+
+    bool search()
+    {
+        if (engine->cleared()) return true;
+        if (context.aborted()) return false;
+        if (!context.countNode()) return false;
+
+        const std::uint64_t hash = boardHash(*engine);
+        if (context.dead.contains(hash)) return false;
+
+        const size_t depth = path.size();
+        if (depth >= movesByDepth.size()) {
+            movesByDepth.resize(depth + 1);
+        }
+        orderedMoves(*engine, counts, movesByDepth[depth]);
+
+        for (size_t i = 0; i < movesByDepth[depth].size(); ++i) {
+            const llk_engine::Move move = movesByDepth[depth][i];
+            engine->eliminate(move.first, move.second);
+            path.push_back(move);
+            if (search()) return true;
+            path.pop_back();
+            engine->undo();
+            // 被中止时子局面未必无解，不能记入哈希表
+            if (context.aborted()) return false;
+        }
+
+        context.dead.insert(hash);
+        return false;
+    }
+
+private:
+    std::unique_ptr<llk_engine> engine;
+    search_context &context;
+    std::vector<int> counts;
+    std::vector<std::vector<llk_engine::Move>> movesByDepth;
+};
+
+} // namespace
+
+solve_result llk_solver::solve(const llk_engine &board, int threads, long long nodeBudget,
+                               long long timeLimitMs, const std::atomic<bool> *cancel)
+{
+    solve_result result;
+    search_context context;
+    context.budget = nodeBudget;
+    context.deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeLimitMs);
+    context.cancel = cancel;
+
+    // 先执行无需分支的消除，直到出现第一个分支点
+    std::unique_ptr<llk_engine> root = board.clone();
+    std::vector<llk_engine::Move> prefix;
+    std::vector<int> counts;
+    std::vector<llk_engine::Move> rootMoves;
+    orderedMoves(*root, counts, rootMoves);
+    while (!root->cleared() && rootMoves.size() == 1) {
+        root->eliminate(rootMoves.front().first, rootMoves.front().second);
+        prefix.push_back(rootMoves.front());
+        ++context.nodes;
+        orderedMoves(*root, counts, rootMoves);
+    }
+
+    if (root->cleared()) {
+        result.status = solve_result::Solved;
+        result.moves = prefix;
+        result.nodes = context.nodes;
+        return result;
+    }
+
+    if (threads <= 0) {
+        threads = static_cast<int>(std::thread::hardware_concurrency());
+    }
+    threads = std::max(1, std::min(threads, static_cast<int>(rootMoves.size())));
+
+    // 分支点的各个选择由线程依次领取，每个线程只复制一次引擎
+    std::atomic<size_t> next{0};
+    auto worker = [&]() {
+        searcher state(*root, context);
+        while (!context.aborted()) {
+            const size_t i = next++;
+            if (i >= rootMoves.size()) break;
+            state.board().eliminate(rootMoves[i].first, rootMoves[i].second);
+            state.path.assign(1, rootMoves[i]);
+            if (state.search()) {
+                std::lock_guard<std::mutex> lock(context.solutionMutex);
+                if (!context.found) {
+                    context.solution = state.path;
+                    context.found = true;
+                }
+                break;
+            }
+            state.board().undo();
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads; ++t) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (std::thread &thread : pool) {
+        thread.join();
+    }
+
+    result.nodes = context.nodes;
+    if (context.found) {
+        result.status = solve_result::Solved;
+        result.moves = prefix;
+        result.moves.insert(result.moves.end(), context.solution.begin(), context.solution.end());
+    } else if (context.exhausted || (cancel && *cancel)) {
+        result.status = solve_result::Unknown;
+    } else {
+        result.status = solve_result::Unsolvable;
+    }
+    return result;
+}
@@ -0,0 +1,37 @@
+#ifndef LLK_SOLVER_H
+#define LLK_SOLVER_H
+
+#include <atomic>
+#include "llk_engine.h"
+
+// 求解结果
+struct solve_result {
+    enum Status {
+        Solved,     // 找到清空棋盘的消除序列
+        Unsolvable, // 已穷尽所有局面，不重排无法清空
+        Unknown     // 超出搜索节点上限、时间上限或被取消
+    };
+
+    Status status = Unknown;
+    // 依次执行即可清空棋盘的消除序列
+    std::vector<llk_engine::Move> moves;
+    long long nodes = 0;
+};
+
+// 多线程深度优先求解器，每个线程在自己的引擎上消除、撤销，不在搜索节点上复制引擎
+// 第一个分支点的各个选择分配给多个线程并行搜索，线程间共享已证明无解局面的哈希表
+// 按剩余数量少的图案优先排序；无重力时某类图案只剩最后一对且可消除，直接消除而不分支
+class llk_solver
+{
+public:
+    static constexpr long long DefaultNodeBudget = 500000;
+    static constexpr long long DefaultTimeLimitMs = 1000;
+
+    // threads 为 0 时使用硬件线程数；超出节点或时间上限、cancel 置为 true 时尽快返回 Unknown
+    static solve_result solve(const llk_engine &board, int threads = 0,
+                              long long nodeBudget = DefaultNodeBudget,
+                              long long timeLimitMs = DefaultTimeLimitMs,
+                              const std::atomic<bool> *cancel = nullptr);
+};
+
+#endif // LLK_SOLVER_H
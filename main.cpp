@@ -1,11 +1,16 @@
 #include "mainwindow.h"
+#include "game_resources.h"
 
 #include <QApplication>
 
 int main(int argc, char *argv[])
 {
+    game_resources::startClock();
     QApplication a(argc, argv);
     MainWindow w;
     w.show();
+    game_resources::logPhase("main menu shown");
+    // 主菜单显示后立即在后台解码资源并预生成棋盘
+    game_resources::preload();
     return a.exec();
 }
@@ -29,11 +29,37 @@ MainWindow::~MainWindow()
 // 基础模式按钮点击事件处理函数
 void MainWindow::on_IDC_BTN_BASIC_clicked()
 {
-    // 基础模式按钮点击事件
-    // 如果基础模式窗口指针为空，说明还未创建基础模式窗口
+    // 基础模式：最多两次拐弯，不穿越边界，无重力
+    openGameWindow(game_variant(), "欢乐连连看--基础模式");
+}
+
+// 休闲模式按钮点击事件处理函数
+void MainWindow::on_IDC_BTN_RELAX_clicked()
+{
+    // 休闲模式：最多三次拐弯，连线可从棋盘一侧穿越到另一侧
+    game_variant variant;
+    variant.maxTurns = 3;
+    variant.wraparound = true;
+    openGameWindow(variant, "欢乐连连看--休闲模式");
+}
+
+// 关卡模式按钮点击事件处理函数
+void MainWindow::on_IDC_BTN_LEVEL_clicked()
+{
+    // 关卡模式：消除后上方的图案下落
+    game_variant variant;
+    variant.gravity = true;
+    openGameWindow(variant, "欢乐连连看--关卡模式");
+}
+
+// 按规则变体打开游戏窗口
+void MainWindow::openGameWindow(const game_variant &variant, const QString &title)
+{
+    // 如果游戏窗口指针为空，说明还未创建游戏窗口
     if (!basic_modeWindow) {
-        // 创建一个新的基础模式窗口对象
-        basic_modeWindow = new basic_mode(nullptr);
+        // 创建一个新的游戏窗口对象
+        basic_modeWindow = new basic_mode(nullptr, variant);
+        basic_modeWindow->setWindowTitle(title);
         // 连接 basic_mode 窗口的关闭信号到槽函数 showAgain
         // 当基础模式窗口被销毁时，会触发 showAgain 函数
         connect(basic_modeWindow, &basic_mode::destroyed, this, &MainWindow::showAgain);
@@ -32,10 +32,17 @@ protected:
 private slots:
     // 基础模式按钮点击事件处理函数
     void on_IDC_BTN_BASIC_clicked();
+    // 休闲模式按钮点击事件处理函数
+    void on_IDC_BTN_RELAX_clicked();
+    // 关卡模式按钮点击事件处理函数
+    void on_IDC_BTN_LEVEL_clicked();
     // 重新显示主窗口的函数
     void showAgain();
 
 private:
+    // 按规则变体打开游戏窗口
+    void openGameWindow(const game_variant &variant, const QString &title);
+
     // 指向用户界面对象的指针
     Ui::MainWindow *ui;
     // 指向基础模式窗口对象的指针